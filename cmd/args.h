@@ -7,9 +7,12 @@
 #include <memory>
 #include <string_view>
 #include <algorithm>
+#include <chrono>
 
 #include "../internal/method_nelder_mead.h"
 #include "../internal/method_random_walk.h"
+#include "../internal/method_grid_scan.h"
+#include "../internal/method_screen_polish.h"
 #include "../internal/test_functions.h"
 
 struct Argumemt {
@@ -18,22 +21,68 @@ struct Argumemt {
 
     std::optional<Area> area;
     size_t dimensions{};
+    std::optional<std::chrono::milliseconds> timeout;
+    std::optional<std::string> share;
+    std::string run;
+    std::optional<std::string> unshare;
+    std::string function_name;
     bool help{};
     bool debug{};
+    bool profile{};
 };
 
 class CLI {
-    static std::unique_ptr<Method> parse_method(const std::string_view method_name, const bool debug) {
+    static std::unique_ptr<Method> parse_method(const std::string_view method_name,
+                                                const std::vector<std::string>&args) {
         auto tracer = Tracer::muted();
-        if (debug) {
+        if (parse_debug(args)) {
             tracer = Tracer::logging();
         }
+        const auto budget = parse_budget(args);
         if (method_name.starts_with("nelder")) {
-            return std::make_unique<NelderMeadMethod>(tracer);
+            auto method = std::make_unique<NelderMeadMethod>(tracer);
+            if (budget.has_value()) {
+                method->restarting(budget.value());
+            }
+            else if (parse_share(args).has_value()) {
+                // a single descent from the border vertexes, the same in every process
+                throw std::invalid_argument("--share with nelder needs --budget");
+            }
+            return method;
+        }
+        if (budget.has_value()) {
+            throw std::invalid_argument("--budget is only supported by nelder");
         }
         if (method_name.starts_with("walk")) {
             return std::make_unique<RandomWalk>(tracer);
         }
+        if (method_name.starts_with("screen")) {
+            return std::make_unique<ScreenAndPolish>(tracer);
+        }
+        if (method_name.starts_with("grid")) {
+            auto method = std::make_unique<GridScan>(tracer);
+            if (auto cells = option_values(args, "-g", "--grid", 1); cells.has_value()) {
+                method = std::make_unique<GridScan>(tracer, parse_size_t(cells->at(0)));
+            }
+            if (auto axes = option_values(args, "--slice", "--slice", 2); axes.has_value()) {
+                auto at = std::optional<double>{};
+                if (auto value = option_values(args, "--at", "--at", 1); value.has_value()) {
+                    at = parse_double(value->at(0));
+                }
+                const auto dimensions = parse_dim(args);
+                for (const auto&axis: axes.value()) {
+                    if (parse_size_t(axis) >= dimensions) {
+                        throw std::invalid_argument("--slice axis " + axis + " is out of " +
+                                                    std::to_string(dimensions) + " dimensions");
+                    }
+                }
+                method->slice({parse_size_t(axes->at(0)), parse_size_t(axes->at(1))}, at);
+            }
+            if (auto output = option_values(args, "-o", "--output", 1); output.has_value()) {
+                method->streaming_to(output->at(0));
+            }
+            return method;
+        }
         throw std::invalid_argument("unexpected method argument");
     }
 
@@ -47,6 +96,23 @@ class CLI {
         throw std::invalid_argument("unexpected function argument");
     }
 
+    // The `count` arguments following `short_name` or `long_name`.
+    static std::optional<std::vector<std::string>> option_values(const std::vector<std::string>&args,
+                                                                 const std::string_view short_name,
+                                                                 const std::string_view long_name,
+                                                                 const size_t count) {
+        for (size_t i = 0; i < args.size(); i++) {
+            if (auto&arg = args[i]; arg == short_name || arg == long_name) {
+                if (i + count >= args.size()) {
+                    throw std::invalid_argument("BAD ARGUMENT, USE --help FOR HELP");
+                }
+                return std::vector(args.begin() + i + 1, args.begin() + i + 1 + count);
+            }
+        }
+
+        return {};
+    }
+
     static bool parse_debug(const std::vector<std::string>&args) {
         for (auto&arg: args) {
             if (arg == "-d" || arg == "--debug") { return true; }
@@ -63,7 +129,7 @@ class CLI {
 
     static size_t parse_size_t(const std::string&value) {
         std::istringstream iss(value);
-        size_t ret;
+        size_t ret{};
         iss >> ret;
         return ret;
     }
@@ -81,19 +147,81 @@ class CLI {
         return 2;
     }
 
+    // shm_open(3) wants names like "/name"
+    static std::string shared_memory_name(const std::string&name) {
+        if (name.starts_with('/')) {
+            return name;
+        }
+        return '/' + name;
+    }
+
+    static std::optional<std::string> parse_share(const std::vector<std::string>&args) {
+        for (size_t i = 0; i < args.size(); i++) {
+            if (auto&arg = args[i]; arg == "-s" || arg == "--share") {
+                if (i + 1 == args.size()) {
+                    throw std::invalid_argument("BAD ARGUMENT, USE --help FOR HELP");
+                }
+                return shared_memory_name(args[i + 1]);
+            }
+        }
+
+        return {};
+    }
+
+    static std::optional<size_t> parse_budget(const std::vector<std::string>&args) {
+        for (size_t i = 0; i < args.size(); i++) {
+            if (auto&arg = args[i]; arg == "-b" || arg == "--budget") {
+                if (i + 1 == args.size()) {
+                    throw std::invalid_argument("BAD ARGUMENT, USE --help FOR HELP");
+                }
+                if (const auto budget = parse_size_t(args[i + 1]); budget != 0) {
+                    return budget;
+                }
+                throw std::invalid_argument("--budget must be a positive number of evaluations");
+            }
+        }
+
+        return {};
+    }
+
+    static std::optional<std::chrono::milliseconds> parse_timeout(const std::vector<std::string>&args) {
+        for (size_t i = 0; i < args.size(); i++) {
+            if (auto&arg = args[i]; arg == "-t" || arg == "--timeout") {
+                if (i + 1 == args.size()) {
+                    throw std::invalid_argument("BAD ARGUMENT, USE --help FOR HELP");
+                }
+                return std::chrono::milliseconds(parse_size_t(args[i + 1]));
+            }
+        }
+
+        return {};
+    }
+
 public:
     static std::string help() {
         return "Simple numberic methods for finding local min/max of functions.\n"
-                "usage: ./nelder [-h -d -a -D] --method <method> --function <function>\n"
+                "usage: ./nelder [-h -d -a -D -b -t -s -g -o] --method <method> --function <function>\n"
                 "\n"
                 "> Required:\n"
-                "-m/--method <nedler | walk> -- method to use (Nelder Mead or Random Walk)\n"
+                "-m/--method <nedler | walk | grid | screen> -- method to use (Nelder Mead, Random Walk, Grid Scan\n"
+                "                               or Random Walk screen polished with Nelder Mead)\n"
                 "-f/--func   <himm | rastr>  -- function to test (Himmelblau (2d), Rastrigin (Nd))\n"
                 "> Optional:\n"
                 "-a/--area   <min> <max>     -- area to to look in (cube [min, max]x[min, max]...)\n"
                 "-D/--dim    <dimension>     -- dimensions N (default: 2)\n"
+                "-b/--budget <evaluations>   -- nelder: restart on stagnation until <evaluations> function calls\n"
+                "-t/--timeout <ms>           -- stop after <ms> milliseconds and print the best point so far\n"
+                "-g/--grid <cells>           -- grid: nodes along each axis (default: 64)\n"
+                "--slice <axis> <axis>       -- grid: scan only these two coordinates\n"
+                "--at <value>                -- grid: value of the other coordinates (default: area's center)\n"
+                "-o/--output <file>          -- grid: write all the values, as CSV if <file> ends with .csv\n"
+                "-s/--share <name>           -- cooperate with other processes through shared memory /dev/shm/<name>\n"
+                "                               (nelder: with --budget only)\n"
+                "--run <id>                  -- share: id of the run, a segment left by another run is refused\n"
+                "--unshare <name>            -- remove the shared memory /dev/shm/<name> and exit\n"
                 "-h/--help                   -- get this help message and exit\n"
                 "-d/--debug                  -- print debug tracing info\n"
+                "--profile                   -- print hardware counters per solver region (NELDERMEAD_PROFILE builds)\n"
                 "\n"
                 "// src: https://github.com/graphomania/nedler2023\n";
     }
@@ -108,7 +236,7 @@ public:
 
     static std::pair<Argumemt, std::optional<std::string>> try_parse(const int argn, char* argv[]) {
         try {
-            return {parse(argn, argv), {}};
+            return {parse(argn, argv), std::nullopt};
         }
         catch (std::invalid_argument&err) {
             return {Argumemt{}, err.what()};
@@ -118,18 +246,31 @@ public:
     static Argumemt parse(const std::vector<std::string>&args) {
         Argumemt arguments{};
         arguments.debug = parse_debug(args);
+        arguments.profile = std::ranges::find(args, "--profile") != args.end();
         arguments.dimensions = parse_dim(args);
+        arguments.timeout = parse_timeout(args);
+        arguments.share = parse_share(args);
+        if (auto run = option_values(args, "--run", "--run", 1); run.has_value()) {
+            arguments.run = run->at(0);
+        }
 
         for (size_t i = 0; i < args.size(); i++) {
             if (auto&arg = args[i]; arg == "-h" || arg == "--help") {
                 arguments.help = true;
                 return arguments;
             }
+            else if (arg == "--unshare") {
+                if (i + 1 == args.size()) {
+                    throw std::invalid_argument("BAD ARGUMENT, USE --help FOR HELP");
+                }
+                arguments.unshare = shared_memory_name(args[i + 1]);
+                return arguments;
+            }
             else if (arg == "-m" || arg == "--method") {
                 if (i + 1 == args.size()) {
                     throw std::invalid_argument("BAD ARGUMENT, USE --help FOR HELP");
                 }
-                arguments.method = parse_method(args[i + 1], arguments.debug);
+                arguments.method = parse_method(args[i + 1], args);
                 i += 1;
             }
             else if (arg == "-f" || arg == "--func" || arg == "--function") {
@@ -137,6 +278,7 @@ public:
                     throw std::invalid_argument("BAD ARGUMENT, USE --help FOR HELP");
                 }
                 arguments.function = parse_function(args[i + 1]);
+                arguments.function_name = args[i + 1];
                 i += 1;
             }
             else if (arg == "-a" || arg == "--area") {
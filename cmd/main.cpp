@@ -1,3 +1,5 @@
+#include <filesystem>
+
 #include "args.h"
 
 using namespace std;
@@ -13,11 +15,62 @@ int main(const int argc, char* argv[]) {
         std::cout << CLI::help();
         return 0;
     }
+    if (args.unshare.has_value()) {
+        SharedIncumbent::unlink(args.unshare.value());
+        return 0;
+    }
 
-    auto [point, value] = args.method->minimal(args.function, args.area.value());
+    if (args.timeout.has_value()) {
+        args.method->stop_when(StopCondition::after(args.timeout.value()));
+    }
 
-    std::cout << args.method->name() << " minimal in area " << args.area->to_string() << "\n"
-            << "point: " << point << ", function value = " << value << "\n";
+    auto shared = std::shared_ptr<SharedIncumbent>{};
+    if (args.share.has_value()) {
+        Point::seed(getpid());
+        try {
+            shared = std::make_shared<SharedIncumbent>(
+                args.share.value(), args.dimensions,
+                args.function_name + ' ' + args.area->to_string() + ' ' + args.run);
+        }
+        catch (std::exception&err) {
+            std::cout << "error: " << err.what() << "\n";
+            return 1;
+        }
+        args.method->share_through(shared);
+    }
+
+    if (args.profile) {
+        profile::enable();
+    }
+
+    if (const auto screen = dynamic_cast<const ScreenAndPolish*>(args.method.get()); screen != nullptr) {
+        std::cout << screen->name() << " minima in area " << args.area->to_string() << "\n";
+        for (auto&[point, value]: screen->minima(args.function, args.area.value())) {
+            std::cout << "point: " << point << ", function value = " << value << "\n";
+        }
+    }
+    else {
+        auto [point, value] = args.method->minimal(args.function, args.area.value());
+
+        std::cout << args.method->name() << " minimal in area " << args.area->to_string() << "\n"
+                << "point: " << point << ", function value = " << value << "\n";
+    }
+
+    if (const auto grid = dynamic_cast<const GridScan*>(args.method.get());
+        grid != nullptr && grid->output().has_value() && !std::filesystem::exists(grid->output().value())) {
+        std::cout << "warning: stopped before the grid was complete, the nodes scanned so far are in "
+                << GridScan::partial(grid->output().value()) << "\n";
+    }
+
+    if (shared != nullptr) {
+        if (auto global = shared->get(); global.has_value()) {
+            std::cout << "shared point: " << global->first << ", function value = " << global->second << "\n";
+        }
+    }
+
+    if (args.profile) {
+        std::cout << profile::report();
+    }
 
     return 0;
 }
@@ -42,8 +42,12 @@ public:
         return Point::random(min_.size(), min_, max_);
     }
 
+    void random_point(Point&out) const {
+        Point::random(out, min_, max_);
+    }
+
     [[nodiscard]] std::vector<Point> border_vertexes() const {
-        auto points = std::vector{min_, max_};
+        auto points = std::vector{Point{std::vector{min_[0]}}, Point{std::vector{max_[0]}}};
         for (size_t i = 1; i < dimensions(); i++) {
             auto next = std::vector<Point>{};
             for (auto&point: points) {
@@ -55,6 +59,29 @@ public:
         return points;
     }
 
+    // Right-angled simplex: `center` and `center` moved along each axis by `scale` of the area's width.
+    [[nodiscard]] std::vector<Point> simplex_around(const Point&center, const double scale) const {
+        if (center.size() != dimensions()) {
+            throw std::invalid_argument("the point is from other dimestion");
+        }
+
+        auto points = std::vector<Point>{center};
+        for (size_t i = 0; i < dimensions(); i++) {
+            auto vertex = center;
+            vertex[i] += (max_[i] - min_[i]) * scale;
+            points.push_back(std::move(vertex));
+        }
+        return points;
+    }
+
+    [[nodiscard]] const Point& min() const {
+        return min_;
+    }
+
+    [[nodiscard]] const Point& max() const {
+        return max_;
+    }
+
     [[nodiscard]] size_t dimensions() const {
         return min_.size();
     }
@@ -0,0 +1,57 @@
+#ifndef BEST_SO_FAR_H
+#define BEST_SO_FAR_H
+
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <optional>
+
+#include "point.h"
+
+// Best point seen by a running method. Written by the method, may be polled from any other thread.
+class BestSoFar {
+    mutable std::mutex mutex_;
+    std::optional<PointValue> best_;
+    // copy of best_->second, lets offer() reject worse points without taking the lock
+    std::atomic<double> value_ = std::numeric_limits<double>::infinity();
+
+public:
+    // Returns true if `point` became the new best one.
+    bool offer(const Point&point, const double value) {
+        if (!(value < value_.load(std::memory_order_relaxed))) {
+            return false;
+        }
+
+        std::lock_guard lock(mutex_);
+        if (best_.has_value() && !(value < best_->second)) {
+            return false;
+        }
+        if (best_.has_value()) {
+            // reuses the buffer, a solver reports every improvement
+            best_->first.assign(point.begin(), point.end());
+            best_->second = value;
+        }
+        else {
+            best_ = {point, value};
+        }
+        value_.store(value, std::memory_order_relaxed);
+        return true;
+    }
+
+    [[nodiscard]] double value() const {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::optional<PointValue> get() const {
+        std::lock_guard lock(mutex_);
+        return best_;
+    }
+
+    void reset() {
+        std::lock_guard lock(mutex_);
+        best_.reset();
+        value_.store(std::numeric_limits<double>::infinity(), std::memory_order_relaxed);
+    }
+};
+
+#endif //BEST_SO_FAR_H
@@ -4,19 +4,26 @@
 #include "point.h"
 #include "area.h"
 
+auto abs(auto val) {
+    if (val < 0) {
+        return -val;
+    }
+    return val;
+}
+
 // Function: R^n --> R
 using Function = std::function<double(const Point&)>;
 
 using std::move;
 
-inline double MSE_with_func_as_extra_coordinate(const Function&func,
-                                                const std::vector<Point>&lhs,
-                                                const std::vector<Point>&rhs) {
+// MSE between two polygons, with the function value as one more coordinate of every vertex.
+inline double MSE_with_values_as_extra_coordinate(const std::vector<Point>&lhs, const std::vector<double>&lhs_values,
+                                                  const std::vector<Point>&rhs, const std::vector<double>&rhs_values) {
     assert(lhs.size() == rhs.size());
 
     double ret = 0;
     for (size_t i = 0; i < lhs.size(); i++) {
-        ret += sqr(lhs[i].extended(func(lhs[i])).distance(rhs[i].extended(func(rhs[i])))) / lhs.size();
+        ret += sqr(lhs[i].distance(rhs[i]) + abs(lhs_values[i] - rhs_values[i])) / lhs.size();
     }
     return ret;
 }
@@ -29,16 +36,28 @@ std::vector<T> sub_vector(const std::vector<T>&vec, size_t begin, size_t end) {
 inline Point centroid(const std::vector<Point>&polygon) {
     auto ret = polygon[0];
     for (size_t i = 1; i < polygon.size(); i++) {
-        ret = ret + polygon[i];
+        ret += polygon[i];
     }
-    return ret / polygon.size();
+    ret *= 1.0 / polygon.size();
+    return ret;
 }
 
-auto abs(auto val) {
-    if (val < 0) {
-        return -val;
+// Centroid of the first `count` vertexes, into `out`'s buffer.
+inline void centroid(Point&out, const std::vector<Point>&polygon, const size_t count) {
+    out.assign(polygon[0].begin(), polygon[0].end());
+    for (size_t i = 1; i < count; i++) {
+        out += polygon[i];
     }
-    return val;
+    out *= 1.0 / count;
+}
+
+// The largest distance from polygon[0] to the other vertexes.
+inline double diameter(const std::vector<Point>&polygon) {
+    double ret = 0;
+    for (size_t i = 1; i < polygon.size(); i++) {
+        ret = std::max(ret, polygon[0].distance(polygon[i]));
+    }
+    return ret;
 }
 
 namespace functional {
@@ -1,11 +1,28 @@
 #ifndef METHOD_H
 #define METHOD_H
 
+#include <memory>
+
 #include "trace.h"
+#include "stop_condition.h"
+#include "best_so_far.h"
+#include "shared_incumbent.h"
 
 class Method {
 protected:
     Tracer tracer_;
+    StopCondition stop_ = StopCondition::never();
+    std::shared_ptr<BestSoFar> best_;
+    std::shared_ptr<SharedIncumbent> shared_;
+
+    void report(const Point&point, const double value) const {
+        if (best_ != nullptr) {
+            best_->offer(point, value);
+        }
+        if (shared_ != nullptr) {
+            shared_->publish(point, value);
+        }
+    }
 
 public:
     virtual ~Method() = default;
@@ -17,6 +34,25 @@ public:
         return "unnamed method";
     }
 
+    // Once `stop` is reached minimal() returns the best point found so far instead of running to the tolerance.
+    Method& stop_when(StopCondition stop) {
+        stop_ = std::move(stop);
+        return *this;
+    }
+
+    // Every improvement is published to `best`, so other threads can watch the progress.
+    Method& report_to(std::shared_ptr<BestSoFar> best) {
+        best_ = std::move(best);
+        return *this;
+    }
+
+    // Cooperate with the other processes attached to `shared`: publish improvements there,
+    // and, for the methods that can, continue from the other processes' best point.
+    Method& share_through(std::shared_ptr<SharedIncumbent> shared) {
+        shared_ = std::move(shared);
+        return *this;
+    }
+
     virtual PointValue minimal(const Function&func, const Area&where) const = 0;
 
     virtual PointValue maximal(const Function&func, const Area&where) const {
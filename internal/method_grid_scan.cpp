@@ -0,0 +1,195 @@
+#include "method_grid_scan.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+
+#include "profile.h"
+
+using namespace std;
+
+void GridScan::write(ostream&out, const bool csv, const vector<double>&values, const size_t first,
+                     const Point&from, const Point&step) const {
+    if (!csv) {
+        out.write(reinterpret_cast<const char*>(values.data()),
+                  static_cast<streamsize>(values.size() * sizeof(double)));
+        return;
+    }
+
+    auto index = vector<size_t>(from.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        auto rest = first + i;
+        for (size_t k = from.size(); k-- > 0;) {
+            index[k] = rest % cells_;
+            rest /= cells_;
+        }
+        for (size_t k = 0; k < from.size(); k++) {
+            out << from[k] + step[k] * index[k] << ',';
+        }
+        out << values[i] << '\n';
+    }
+}
+
+PointValue GridScan::minimal(const Function&func, const Area&where) const {
+    const Function&objective = profile::objective(func);
+    auto axes = axes_;
+    if (axes.empty()) {
+        axes.resize(where.dimensions());
+        iota(axes.begin(), axes.end(), 0);
+    }
+
+    // coordinates that are not scanned keep the values of `origin`
+    auto origin = (where.min() + where.max()) / 2;
+    if (at_.has_value()) {
+        ranges::fill(origin, at_.value());
+    }
+
+    auto from = Point{};
+    auto step = Point{};
+    size_t total = 1;
+    for (const auto axis: axes) {
+        if (axis >= where.dimensions()) {
+            throw invalid_argument("the slice is from other dimestion");
+        }
+        if (total > numeric_limits<size_t>::max() / cells_) {
+            throw invalid_argument("the grid is too large");
+        }
+        from.push_back(where.min()[axis]);
+        step.push_back((where.max()[axis] - where.min()[axis]) / static_cast<double>(cells_ - 1));
+        total *= cells_;
+    }
+
+    const auto tile = clamp(total / (threads_ * 4), size_t{64}, max_tile);
+    const auto tiles = (total + tile - 1) / tile;
+
+    auto out = ofstream{};
+    const auto csv = output_.has_value() && output_->ends_with(".csv");
+    if (output_.has_value()) {
+        // a file left by an earlier scan would pass for the result of this one
+        filesystem::remove(output_.value());
+        out.open(partial(output_.value()), csv ? ios::out : ios::out | ios::binary);
+        if (!out) {
+            throw invalid_argument("can't open " + partial(output_.value()));
+        }
+    }
+
+    // finished tiles wait in `done` until all the tiles before them are written,
+    // no thread may run more than `window` tiles ahead of the writer
+    const auto window = threads_ * 4;
+    mutex mutex;
+    condition_variable cv;
+    map<size_t, vector<double>> done;
+    size_t written = 0, finished = 0;
+    auto abandoned = false;
+
+    atomic<size_t> next_tile = 0;
+    auto bests = vector<PointValue>(threads_, {Point{}, numeric_limits<double>::infinity()});
+
+    auto worker = [&](PointValue&best) {
+        auto point = origin;
+        auto index = vector<size_t>(axes.size());
+        auto values = vector<double>{};
+
+        auto t = next_tile++;
+        for (; t < tiles && !stop_.reached(); t = next_tile++) {
+            if (out.is_open()) {
+                unique_lock lock(mutex);
+                cv.wait(lock, [&] { return t < written + window || abandoned; });
+                if (abandoned) {
+                    break;
+                }
+            }
+
+            const auto first = t * tile;
+            const auto last = std::min(total, first + tile);
+            auto rest = first;
+            for (size_t k = axes.size(); k-- > 0;) {
+                index[k] = rest % cells_;
+                rest /= cells_;
+                point[axes[k]] = from[k] + step[k] * index[k];
+            }
+
+            const auto before = best.second;
+            for (auto node = first; node < last; node++) {
+                const auto value = objective(point);
+                if (out.is_open()) {
+                    values.push_back(value);
+                }
+                if (value < best.second) {
+                    best = {point, value};
+                }
+
+                // odometer over the scanned axes, the last one runs fastest
+                for (size_t k = axes.size(); k-- > 0;) {
+                    if (++index[k] < cells_) {
+                        point[axes[k]] = from[k] + step[k] * index[k];
+                        break;
+                    }
+                    index[k] = 0;
+                    point[axes[k]] = from[k];
+                }
+            }
+            if (best.second < before) {
+                report(best.first, best.second);
+            }
+
+            if (out.is_open()) {
+                lock_guard lock(mutex);
+                done.emplace(t, std::move(values));
+                values = {};
+                cv.notify_all();
+            }
+        }
+
+        lock_guard lock(mutex);
+        finished += 1;
+        // stopped with the tile `t` claimed, so the output can't be completed
+        abandoned = abandoned || t < tiles;
+        cv.notify_all();
+    };
+
+    auto threads = vector<jthread>{};
+    for (size_t i = 0; i < threads_; i++) {
+        threads.emplace_back(worker, ref(bests[i]));
+    }
+
+    if (out.is_open()) {
+        unique_lock lock(mutex);
+        while (written < tiles) {
+            cv.wait(lock, [&] { return done.contains(written) || abandoned || finished == threads_; });
+            if (!done.contains(written)) {
+                break; // stopped, the rest of the grid is never coming
+            }
+            auto values = std::move(done.at(written));
+            done.erase(written);
+
+            lock.unlock();
+            write(out, csv, values, written * tile, from, step);
+            lock.lock();
+
+            written += 1;
+            cv.notify_all();
+        }
+    }
+    threads.clear();
+
+    if (out.is_open()) {
+        out.close();
+        if (written == tiles) {
+            filesystem::rename(partial(output_.value()), output_.value());
+        }
+    }
+
+    auto best = *ranges::min_element(bests, {}, &PointValue::second);
+    if (best.first.empty()) {
+        // stopped before a single tile
+        best = {origin, func(origin)};
+    }
+    tracer_.trace(best.first, best.second);
+    return best;
+}
@@ -0,0 +1,71 @@
+#ifndef GRID_SCAN_H
+#define GRID_SCAN_H
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "common.h"
+#include "method.h"
+
+// Evaluates a regular grid over the area, or over a slice of it, and returns the best node.
+// The grid is split into tiles of consecutive nodes that the threads take one by one.
+class GridScan final : public Method {
+    // values of a tile fit into L1
+    static constexpr size_t max_tile = 4096;
+
+    size_t cells_;
+    size_t threads_;
+    std::vector<size_t> axes_;
+    std::optional<double> at_;
+    std::optional<std::string> output_;
+
+    void write(std::ostream&out, bool csv, const std::vector<double>&values, size_t first,
+               const Point&from, const Point&step) const;
+
+public:
+    // `cells` nodes along each scanned axis, borders included.
+    explicit GridScan(Tracer tracer = Tracer::muted(), const size_t cells = 64,
+                      const size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+        : Method(std::move(tracer)),
+          cells_(std::max<size_t>(cells, 2)),
+          threads_(std::max<size_t>(threads, 1)) {
+    }
+
+    // Scan only the coordinates `axes`, the others are fixed to `at`, or to the area's center if it's empty.
+    GridScan& slice(std::vector<size_t> axes, const std::optional<double> at = {}) {
+        for (auto it = axes.begin(); it != axes.end(); ++it) {
+            if (std::find(axes.begin(), it, *it) != it) {
+                throw std::invalid_argument("axis " + std::to_string(*it) + " is sliced twice");
+            }
+        }
+        axes_ = std::move(axes);
+        at_ = at;
+        return *this;
+    }
+
+    // Write every node to `path`: "<scanned coordinates>,value" lines if it ends with ".csv",
+    // otherwise the values only, as native doubles. Either way the last scanned axis runs fastest.
+    // The nodes go to partial(path) first, which is renamed to `path` once the grid is complete,
+    // so a scan that's stopped early leaves no `path` at all.
+    GridScan& streaming_to(std::string path) {
+        output_ = std::move(path);
+        return *this;
+    }
+
+    [[nodiscard]] const std::optional<std::string>& output() const {
+        return output_;
+    }
+
+    [[nodiscard]] static std::string partial(const std::string&path) {
+        return path + ".partial";
+    }
+
+    [[nodiscard]] std::string name() const override { return "grid scan"; }
+
+    [[nodiscard]] PointValue minimal(const Function&func, const Area&where) const override;
+};
+
+#endif //GRID_SCAN_H
@@ -1,63 +1,162 @@
 #include "method_nelder_mead.h"
+#include "profile.h"
 
 using namespace std;
 
-PointValue NelderMeadMethod::minimal_internal(const Function&func, vector<Point>&x) const {
-    auto return_or_go_deeper = [&, prev_x = x]() -> PointValue {
-        const auto mse = MSE_with_func_as_extra_coordinate(func, x, prev_x);
-        if (mse < tolerance_) {
-            return {x[0], func(x[0])};
+// Insertion sort of `x` by `fx`: after a step only the last vertex is out of place,
+// so it's linear in the usual case.
+static void order(vector<Point>&x, vector<double>&fx) {
+    PROFILE_SCOPE(order);
+    for (size_t i = 1; i < x.size(); i++) {
+        for (size_t j = i; j > 0 && fx[j] < fx[j - 1]; j--) {
+            swap(x[j], x[j - 1]);
+            swap(fx[j], fx[j - 1]);
         }
-        // tracer_.trace()
-        tracer_.trace_polygon(x, prev_x, mse);
-        return minimal_internal(func, x);
-    };
+    }
+}
 
+NelderMeadMethod::DescentEnd NelderMeadMethod::minimal_internal(const Function&func, vector<Point>&x,
+                                                                vector<double>&fx,
+                                                                const size_t&evaluations) const {
     // 1. Order
-    ranges::sort(x, [&](const auto&lhs, const auto&rhs) -> bool {
-        return func(lhs) < func(rhs);
-    });
+    fx.resize(x.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        fx[i] = func(x[i]);
+    }
+    order(x, fx);
+    report(x[0], fx[0]);
+
+    auto ws = Workspace{};
+    const auto initial_diameter = diameter(x);
+    auto best = fx[0];
+    const auto start_value = fx[0];
+    size_t since_improvement = 0;
+
+    while (true) {
+        // an iteration costs a few evaluations per vertex, so the clock is read every time
+        if (stop_.reached()) {
+            return DescentEnd::stopped;
+        }
+        if (max_evaluations_ != 0 && evaluations >= max_evaluations_) {
+            return DescentEnd::out_of_budget;
+        }
+
+        // element-wise copy assignment, the buffers of the previous iteration are reused
+        ws.prev_x = x;
+        ws.prev_fx = fx;
+        step(func, x, fx, ws);
+
+        // one scope for all the checks of the iteration, the ordering inside it counts as its own
+        PROFILE_SCOPE(convergence);
+        const auto mse = MSE_with_values_as_extra_coordinate(x, fx, ws.prev_x, ws.prev_fx);
+        order(x, fx);
+        // before any return below, so the reported best is never worse than the returned one
+        report(x[0], fx[0]);
+        if (mse < tolerance_) {
+            return DescentEnd::converged;
+        }
+        tracer_.trace_polygon(x, ws.prev_x, mse);
+
+        if (patience_ == 0) {
+            continue;
+        }
+        if (fx[0] < best - 1e-9 * (1 + abs(best))) {
+            best = fx[0];
+            since_improvement = 0;
+        }
+        else if (++since_improvement >= patience_) {
+            return DescentEnd::stagnated;
+        }
+        else if (shared_ != nullptr && since_improvement >= patience_ / 2) {
+            // behind the other processes by more than this descent has gained so far
+            if (const auto global = shared_->value();
+                global.has_value() && fx[0] - global.value() > start_value - fx[0]) {
+                return DescentEnd::pruned;
+            }
+        }
+        if (diameter(x) < collapse_ratio * initial_diameter) {
+            return DescentEnd::collapsed;
+        }
+    }
+}
+
+void NelderMeadMethod::step(const Function&func, vector<Point>&x, vector<double>&fx, Workspace&ws) const {
+    PROFILE_SCOPE(step);
+    // accepted points are swapped into the simplex, the replaced vertex becomes scratch
+    auto&x_o = ws.x_o, &x_r = ws.x_r, &x_e = ws.x_e, &x_c = ws.x_c;
 
     // 2. Calculate x_o, the centroid of all points except x_n+1
-    const auto x_o = centroid(sub_vector(x, 0, x.size() - 1));
+    {
+        PROFILE_SCOPE(centroid);
+        centroid(x_o, x, x.size() - 1);
+    }
 
-    // 3. Reflection
-    const auto x_r = x_o + (x_o - x.back()) * alpha_;
-    if (func(x[0]) <= func(x_r) && func(x_r) < func(x[x.size() - 2])) {
-        x.back() = x_r;
-        return return_or_go_deeper();
+    // 3. Reflection: x_o + (x_o - x_n+1) * alpha
+    Point::lerp(x_r, x_o, x.back(), -alpha_);
+    const auto f_r = func(x_r);
+    if (fx[0] <= f_r && f_r < fx[x.size() - 2]) {
+        swap(x.back(), x_r);
+        fx.back() = f_r;
+        return;
     }
 
     // 4. Expansion
-    if (func(x_r) < func(x[0])) {
-        if (const auto x_e = x_o + (x_r - x_o) * gamma_; func(x_e) < func(x_r)) {
-            x.back() = x_e;
-            return return_or_go_deeper();;
+    if (f_r < fx[0]) {
+        Point::lerp(x_e, x_o, x_r, gamma_);
+        if (const auto f_e = func(x_e); f_e < f_r) {
+            swap(x.back(), x_e);
+            fx.back() = f_e;
+            return;
         }
 
-        x.back() = x_r;
-        return return_or_go_deeper();
+        swap(x.back(), x_r);
+        fx.back() = f_r;
+        return;
     }
 
     // 5. Contraction
-    if (func(x_r) >= func(x[x.size() - 2])) {
-        if (func(x_r) < func(x.back())) {
-            if (const auto x_c = x_o + (x_r - x_o) * rho_; func(x_c) < func(x_r)) {
-                x.back() = x_c;
-                return return_or_go_deeper();
-            }
-        }
-        else {
-            if (const auto x_c = x_o + (x.back() - x_o) * rho_; func(x_c) < func(x_r)) {
-                x.back() = x_c;
-                return return_or_go_deeper();
-            }
+    if (f_r >= fx[x.size() - 2]) {
+        Point::lerp(x_c, x_o, f_r < fx.back() ? x_r : x.back(), rho_);
+        if (const auto f_c = func(x_c); f_c < f_r) {
+            swap(x.back(), x_c);
+            fx.back() = f_c;
+            return;
         }
     }
 
     // 6. Shrink
     for (size_t i = 1; i < x.size(); i++) {
-        x[i] = x[0] + (x[i] - x[0]) * sigma_;
+        Point::lerp(x[i], x[0], x[i], sigma_);
+        fx[i] = func(x[i]);
+    }
+}
+
+PointValue NelderMeadMethod::minimal_restarting(const Function&func, const Area&where) const {
+    size_t evaluations = 0;
+    const Function counted = [&](const Point&point) {
+        evaluations += 1;
+        return func(point);
+    };
+
+    // the border vertexes alone would cost 2^dimensions calls, and cooperating processes
+    // would all descend from the same corners
+    auto x = start_.has_value() ? start_.value() : where.simplex_around(where.random_point(), restart_scale_);
+
+    auto fx = vector<double>{};
+    auto end = minimal_internal(counted, x, fx, evaluations);
+    auto best = PointValue{x[0], fx[0]};
+    auto improved = true;
+
+    while (end != DescentEnd::stopped && end != DescentEnd::out_of_budget) {
+        // around the best point while that keeps paying off, otherwise somewhere else
+        x = where.simplex_around(improved ? best.first : where.random_point(), restart_scale_);
+        end = minimal_internal(counted, x, fx, evaluations);
+
+        improved = fx[0] < best.second;
+        if (improved) {
+            best = {x[0], fx[0]};
+            tracer_.trace_numbered(best.first, best.second);
+        }
     }
-    return return_or_go_deeper();
+    return best;
 }
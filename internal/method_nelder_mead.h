@@ -5,6 +5,7 @@
 
 #include "common.h"
 #include "method.h"
+#include "profile.h"
 
 struct NelderMeadDebugInfo {
     bool debug = false;
@@ -20,6 +21,17 @@ struct NelderMeadDebugInfo {
 
 
 class NelderMeadMethod final : public Method {
+    // Why a single descent (see minimal_internal) has ended.
+    enum class DescentEnd { converged, stagnated, collapsed, pruned, out_of_budget, stopped };
+
+    // Scratch points of a descent. Buffers get their size on the first iteration and are reused after,
+    // so iterations don't allocate.
+    struct Workspace {
+        Point x_o, x_r, x_e, x_c;
+        std::vector<Point> prev_x;
+        std::vector<double> prev_fx;
+    };
+
     std::optional<std::vector<Point>> start_;
     double tolerance_;
     double alpha_;
@@ -27,11 +39,25 @@ class NelderMeadMethod final : public Method {
     double rho_;
     double sigma_;
 
+    // restarts, see restarting(); disabled while max_evaluations_ == 0
+    size_t max_evaluations_ = 0;
+    size_t patience_ = 0;
+    double restart_scale_ = 0;
+    static constexpr double collapse_ratio = 1e-6;
+
     // https://en.wikipedia.org/wiki/Nelder–Mead_method
     // alpha > 0
     // gamma > 1
     // 0 < rho <= 0.5
-    PointValue minimal_internal(const Function&func, std::vector<Point>&x) const;
+    //
+    // Descends from the simplex `x`, on return `x` is ordered and `fx` holds its function values.
+    DescentEnd minimal_internal(const Function&func, std::vector<Point>&x, std::vector<double>&fx,
+                                const size_t&evaluations) const;
+
+    // A single reflection / expansion / contraction / shrink of the ordered simplex `x`.
+    void step(const Function&func, std::vector<Point>&x, std::vector<double>&fx, Workspace&ws) const;
+
+    PointValue minimal_restarting(const Function&func, const Area&where) const;
 
 public:
     // If NedlerMeadMethod's (start == None) => (it's chosen randomly each run)
@@ -56,9 +82,33 @@ public:
         return *this;
     }
 
+    // Spend up to `max_evaluations` function calls instead of stopping at the first local minimum.
+    // Without a start, every descent begins from a simplex around a random point, never from
+    // the area's 2^dimensions border vertexes. The budget is checked between iterations, so the last one
+    // (a reflection, a contraction and a shrink) or a restart's initial simplex may overshoot it
+    // by up to dimensions + 1 calls.
+    // A descent ends when it converges, its best value hasn't improved for `patience` iterations
+    // or the simplex has collapsed. Then the simplex is rebuilt around the best point with edges
+    // `scale` times the area's size, or, if the last restart didn't improve anything,
+    // around a random point of the area.
+    // With share_through() a descent that stalls for half of `patience` is given up
+    // if it's behind the other processes' best by more than it has gained.
+    NelderMeadMethod& restarting(const size_t max_evaluations, const size_t patience = 32,
+                                 const double scale = 0.1) {
+        max_evaluations_ = max_evaluations;
+        patience_ = patience;
+        restart_scale_ = scale;
+        return *this;
+    }
+
     [[nodiscard]] std::string name() const override { return "Nelder Mead method"; }
 
     [[nodiscard]] PointValue minimal(const Function&func, const Area&where) const override {
+        const Function&objective = profile::objective(func);
+        if (max_evaluations_ != 0) {
+            return minimal_restarting(objective, where);
+        }
+
         auto x = std::vector<Point>{};
         if (start_.has_value()) {
             x = start_.value();
@@ -67,7 +117,9 @@ public:
             x = where.border_vertexes();
         }
 
-        return minimal_internal(func, x);
+        auto fx = std::vector<double>{};
+        minimal_internal(objective, x, fx, 0);
+        return {x[0], fx[0]};
     }
 };
 
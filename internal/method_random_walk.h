@@ -7,6 +7,7 @@
 #include "common.h"
 #include "trace.h"
 #include "method.h"
+#include "profile.h"
 
 
 class RandomWalk final : public Method {
@@ -25,12 +26,20 @@ public:
     [[nodiscard]] std::string name() const override { return "random walk method"; }
 
     [[nodiscard]] PointValue minimal(const Function&func, const Area&where) const override {
+        const Function&objective = profile::objective(func);
         std::optional<PointValue> min;
+        // the sample's buffer, swapped with the minimum's on improvement
+        auto point = Point{};
         for (size_t iter = 1; min_ > iter || iter <= max_; iter++) {
-            auto point = where.random_point();
-            const auto value = func(point);
+            if (min.has_value() && stop_.reached(iter)) {
+                return min.value();
+            }
+
+            where.random_point(point);
+            const auto value = objective(point);
             if (!min.has_value()) {
-                min = {std::move(point), value};
+                min = {point, value};
+                report(min->first, min->second);
                 tracer_.trace_numbered(min->first, min->second);
                 continue;
             }
@@ -40,7 +49,9 @@ public:
             }
 
             if (value < min.value().second) {
-                min = {point, value};
+                std::swap(min->first, point);
+                min->second = value;
+                report(min->first, min->second);
                 tracer_.trace_numbered(min->first, min->second);
             }
         }
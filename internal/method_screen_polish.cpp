@@ -0,0 +1,178 @@
+#include "method_screen_polish.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "method_nelder_mead.h"
+#include "profile.h"
+
+using namespace std;
+
+// Fixed number of threads taking tasks in order, joins them all on destruction.
+class ThreadPool {
+    mutex mutex_;
+    condition_variable cv_;
+    deque<function<void()>> tasks_;
+    bool closed_ = false;
+    vector<jthread> threads_;
+
+public:
+    explicit ThreadPool(const size_t threads) {
+        for (size_t i = 0; i < threads; i++) {
+            threads_.emplace_back([this] {
+                while (true) {
+                    auto task = function<void()>{};
+                    {
+                        unique_lock lock(mutex_);
+                        cv_.wait(lock, [this] { return closed_ || !tasks_.empty(); });
+                        if (tasks_.empty()) {
+                            return;
+                        }
+                        task = std::move(tasks_.front());
+                        tasks_.pop_front();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard lock(mutex_);
+            closed_ = true;
+        }
+        cv_.notify_all();
+        threads_.clear();
+    }
+
+    void submit(function<void()> task) {
+        {
+            lock_guard lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+};
+
+// Both points are within `distinct` of the area's width along every axis.
+static bool same_basin(const Point&lhs, const Point&rhs, const Area&where, const double distinct) {
+    for (size_t i = 0; i < lhs.size(); i++) {
+        if (abs(lhs[i] - rhs[i]) > distinct * (where.max()[i] - where.min()[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+vector<PointValue> ScreenAndPolish::minima(const Function&func, const Area&where) const {
+    struct Candidate {
+        PointValue sample;
+        bool polished = false;
+    };
+    // max-heap by value: the worst of the kept candidates is on top, ready to be evicted
+    const auto worse = [](const Candidate&lhs, const Candidate&rhs) {
+        return lhs.sample.second < rhs.sample.second;
+    };
+    auto heap = vector<Candidate>{};
+    // the descents count their own objective calls
+    const Function&screening = profile::objective(func);
+
+    mutex mutex;
+    auto found = vector<PointValue>{};
+
+    {
+        // declared before the pool, whose destructor still runs the queued tasks
+        const auto polish = [&](PointValue minimum) {
+            // A descent may stop while only its worst vertex is still creeping and hand back
+            // its start untouched, so a descent that doesn't improve is tried again from the simplex
+            // mirrored through the point, then from smaller ones, until they are negligible.
+            // A task left for after the deadline reports its screened sample.
+            for (auto scale = distinct_; scale > min_scale && !stop_.reached();) {
+                auto improved = false;
+                for (const auto side: {scale, -scale}) {
+                    auto method = NelderMeadMethod(Tracer::muted(), 1e-12, where.simplex_around(minimum.first, side));
+                    method.stop_when(stop_).report_to(best_).share_through(shared_);
+
+                    if (auto next = method.minimal(func, where);
+                        next.second < minimum.second - 1e-9 * (1 + abs(next.second))) {
+                        minimum = std::move(next);
+                        improved = true;
+                        break;
+                    }
+                }
+                if (!improved) {
+                    scale /= 4;
+                }
+            }
+
+            lock_guard lock(mutex);
+            found.push_back(std::move(minimum));
+        };
+        auto pool = ThreadPool(threads_);
+
+        auto batch = vector<PointValue>(batch_);
+        for (size_t done = 0; done < samples_ && !stop_.reached(); done += batch_) {
+            batch.resize(std::min(batch_, samples_ - done));
+            for (auto&[point, value]: batch) {
+                point = where.random_point();
+                value = screening(point);
+            }
+
+            for (auto&sample: batch) {
+                report(sample.first, sample.second);
+                if (heap.size() == candidates_ && !(sample.second < heap.front().sample.second)) {
+                    continue;
+                }
+
+                // the same basin as one of the kept candidates: keep the better one of the two,
+                // but a polished candidate has done its job and stays
+                auto near = ranges::find_if(heap, [&](const Candidate&candidate) {
+                    return same_basin(candidate.sample.first, sample.first, where, distinct_);
+                });
+                if (near != heap.end()) {
+                    if (!near->polished && sample.second < near->sample.second) {
+                        near->sample = std::move(sample);
+                        ranges::make_heap(heap, worse);
+                    }
+                    continue;
+                }
+
+                if (heap.size() == candidates_) {
+                    ranges::pop_heap(heap, worse);
+                    heap.pop_back();
+                }
+                heap.push_back({std::move(sample), false});
+                ranges::push_heap(heap, worse);
+            }
+
+            // candidates evicted by later batches have been polished already, see the class comment
+            for (auto&candidate: heap) {
+                if (!candidate.polished) {
+                    candidate.polished = true;
+                    tracer_.trace_numbered(candidate.sample.first, candidate.sample.second);
+                    pool.submit([&polish, sample = candidate.sample] { polish(sample); });
+                }
+            }
+        }
+    }
+
+    // descents from different candidates may end up in the same minimum
+    ranges::sort(found, {}, &PointValue::second);
+    auto ret = vector<PointValue>{};
+    for (auto&minimum: found) {
+        if (ranges::none_of(ret, [&](const PointValue&better) {
+            return same_basin(better.first, minimum.first, where, distinct_);
+        })) {
+            ret.push_back(std::move(minimum));
+        }
+    }
+    if (ret.empty()) {
+        // stopped before the first batch
+        auto point = where.random_point();
+        const auto value = func(point);
+        ret.emplace_back(std::move(point), value);
+    }
+    return ret;
+}
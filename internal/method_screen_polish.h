@@ -0,0 +1,50 @@
+#ifndef SCREEN_POLISH_H
+#define SCREEN_POLISH_H
+
+#include <thread>
+
+#include "common.h"
+#include "method.h"
+
+// Random sampling of the area ("screen") and Nelder Mead descents from the best samples ("polish").
+// The screen keeps the best `candidates` samples that are at least `distinct` apart and,
+// after every batch, hands the new ones to a pool of threads, so polishing starts
+// while the screen is still running.
+// `candidates` bounds the samples kept at a time, not the polishing: a candidate polished after
+// one batch stays polished even if later batches push it out, so the number of descents, and of
+// the minima returned, grows with the number of batches that bring in better samples.
+class ScreenAndPolish final : public Method {
+    // polishing a candidate ends when descents from simplexes this small (of the area's width) don't improve it
+    static constexpr double min_scale = 1e-6;
+
+    size_t samples_;
+    size_t batch_;
+    size_t candidates_;
+    double distinct_;
+    size_t threads_;
+
+public:
+    // `distinct` is a fraction of the area's width along each axis.
+    explicit ScreenAndPolish(Tracer tracer = Tracer::muted(), const size_t samples = 4096,
+                             const size_t batch = 256, const size_t candidates = 8, const double distinct = 0.05,
+                             const size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+        : Method(std::move(tracer)),
+          samples_(samples),
+          batch_(std::max<size_t>(batch, 1)),
+          candidates_(std::max<size_t>(candidates, 1)),
+          distinct_(distinct),
+          threads_(std::max<size_t>(threads, 1)) {
+    }
+
+    [[nodiscard]] std::string name() const override { return "screen and polish method"; }
+
+    // Distinct local minima of every polished candidate, the best first. When stopped, the candidates whose polishing
+    // hadn't finished are returned as far as it got, down to the screened sample.
+    [[nodiscard]] std::vector<PointValue> minima(const Function&func, const Area&where) const;
+
+    [[nodiscard]] PointValue minimal(const Function&func, const Area&where) const override {
+        return minima(func, where).front();
+    }
+};
+
+#endif //SCREEN_POLISH_H
@@ -24,6 +24,11 @@ class Point : public std::vector<double> {
             throw std::invalid_argument("sizes dont match");
     }
 
+    static std::default_random_engine& random_engine() {
+        static std::default_random_engine re;
+        return re;
+    }
+
 public:
     [[nodiscard]] double distance(const Point&other) const {
         assert_match_sizes(other);
@@ -35,29 +40,63 @@ public:
     }
 
     Point operator+(const Point&other) const {
-        assert_match_sizes(other);
+        auto ret = *this;
+        ret += other;
+        return ret;
+    }
 
-        auto ret = Point{};
-        ret.resize(size());
+    Point operator-(const Point&other) const {
+        auto ret = *this;
+        ret -= other;
+        return ret;
+    }
+
+    Point operator*(const double x) const {
+        auto ret = *this;
+        ret *= x;
+        return ret;
+    }
+
+    // The compound operations below work in place and never allocate.
+
+    Point& operator+=(const Point&other) {
+        assert_match_sizes(other);
 
         for (size_t i = 0; i < size(); i++) {
-            ret[i] = at(i) + other.at(i);
+            (*this)[i] += other[i];
         }
+        return *this;
+    }
 
-        return ret;
+    Point& operator-=(const Point&other) {
+        return axpy(-1, other);
     }
 
-    Point operator-(const Point&other) const {
-        return *this + other * (-1);
+    Point& operator*=(const double x) {
+        for (auto&i: *this) {
+            i *= x;
+        }
+        return *this;
     }
 
-    Point operator*(const double x) const {
-        auto ret = Point{};
-        ret.resize(size());
+    // this += a * x
+    Point& axpy(const double a, const Point&x) {
+        assert_match_sizes(x);
+
         for (size_t i = 0; i < size(); i++) {
-            ret[i] = at(i) * x;
+            (*this)[i] += a * x[i];
+        }
+        return *this;
+    }
+
+    // out = from + (to - from) * t, reusing out's buffer; `out` may be `from` or `to` itself.
+    static void lerp(Point&out, const Point&from, const Point&to, const double t) {
+        from.assert_match_sizes(to);
+
+        out.resize(from.size());
+        for (size_t i = 0; i < from.size(); i++) {
+            out[i] = from[i] + (to[i] - from[i]) * t;
         }
-        return ret;
     }
 
     Point operator/(const double x) const {
@@ -70,8 +109,13 @@ public:
         return copy;
     }
 
+    // Every process generates the same points unless seeded differently.
+    static void seed(const unsigned seed) {
+        random_engine().seed(seed);
+    }
+
     static Point random(const size_t dimension, const double min, const double max) {
-        static std::default_random_engine re;
+        auto&re = random_engine();
 
         auto ret = Point{};
         ret.resize(dimension);
@@ -83,19 +127,28 @@ public:
     }
 
     static Point random(const size_t dimension, const Point&min, const Point&max) {
-        static std::default_random_engine re;
-
         if (dimension != min.size() || min.size() != max.size()) {
             throw std::invalid_argument("dimension == min.size() == max.size() is required");
         }
 
         auto ret = Point{};
-        ret.resize(dimension);
-        for (size_t i = 0; i < dimension; i++) {
+        random(ret, min, max);
+        return ret;
+    }
+
+    // Same as above, into `out`'s buffer.
+    static void random(Point&out, const Point&min, const Point&max) {
+        auto&re = random_engine();
+
+        if (min.size() != max.size()) {
+            throw std::invalid_argument("min.size() == max.size() is required");
+        }
+
+        out.resize(min.size());
+        for (size_t i = 0; i < min.size(); i++) {
             std::uniform_real_distribution unif(min[i], max[i]);
-            ret[i] = unif(re);
+            out[i] = unif(re);
         }
-        return ret;
     }
 
     static vector<Point> generate_vector(const size_t size, const size_t dimensions,
@@ -0,0 +1,420 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <string>
+
+#include "common.h"
+
+// Hardware counters (perf_event_open(2)) per region of the solvers' hot paths, for `--profile`.
+// Only built with -DNELDERMEAD_PROFILE, otherwise PROFILE_SCOPE expands to nothing
+// and profile::objective() hands the function back untouched.
+namespace profile {
+    enum class Region { objective, order, centroid, step, convergence };
+}
+
+#ifdef NELDERMEAD_PROFILE
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace profile {
+    constexpr std::array region_names = {"objective", "order", "centroid", "step", "convergence"};
+
+    // cycles, instructions, cache-misses, branch-misses of the calling thread, user space only
+    //
+    // Every event's page is mapped so that, where the kernel allows it, the counters are read with
+    // rdpmc in user space (see "perf_event_mmap_page" in perf_event_open(2)). Otherwise each read
+    // is a read(2) of the whole group, a syscall that costs far more than a cheap objective.
+    class Counters {
+        static constexpr std::array<uint64_t, 4> events = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+        };
+
+        std::array<int, events.size()> fds_{-1, -1, -1, -1};
+        std::array<const volatile perf_event_mmap_page*, events.size()> pages_{};
+        size_t page_size_ = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+#if defined(__x86_64__) || defined(__i386__)
+        static uint64_t rdpmc(const uint32_t counter) {
+            uint32_t low, high;
+            asm volatile("rdpmc" : "=a"(low), "=d"(high) : "c"(counter));
+            return static_cast<uint64_t>(high) << 32 | low;
+        }
+#endif
+
+    public:
+        using Values = std::array<uint64_t, events.size()>;
+
+        Counters() = default;
+
+        Counters(const Counters&) = delete;
+
+        Counters& operator=(const Counters&) = delete;
+
+        ~Counters() {
+            close();
+        }
+
+        // Returns an error message, or an empty string on success.
+        std::string open() {
+            for (size_t i = 0; i < events.size(); i++) {
+                perf_event_attr attr{};
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = events[i];
+                attr.disabled = i == 0;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP;
+
+                // all the events are one group, so a single read() gets them together
+                fds_[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds_[0], 0));
+                if (fds_[i] < 0) {
+                    const auto error = std::string("perf_event_open: ") + std::strerror(errno);
+                    close();
+                    return error;
+                }
+
+                // without the page the counters are still there, through read()
+                if (auto* page = mmap(nullptr, page_size_, PROT_READ, MAP_SHARED, fds_[i], 0); page != MAP_FAILED) {
+                    pages_[i] = static_cast<const volatile perf_event_mmap_page*>(page);
+                }
+            }
+            ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            return {};
+        }
+
+        void close() {
+            for (auto&page: pages_) {
+                if (page != nullptr) {
+                    munmap(const_cast<perf_event_mmap_page*>(page), page_size_);
+                }
+                page = nullptr;
+            }
+            for (auto&fd: fds_) {
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                fd = -1;
+            }
+        }
+
+        [[nodiscard]] bool opened() const {
+            return fds_[0] >= 0;
+        }
+
+        // The counters without a syscall, false if any of them can't be read that way right now
+        // (no rdpmc on this CPU or kernel, or the event is not on a hardware counter at the moment).
+        [[nodiscard]] bool read_user(Values&values) const {
+#if defined(__x86_64__) || defined(__i386__)
+            for (size_t i = 0; i < events.size(); i++) {
+                const auto* page = pages_[i];
+                if (page == nullptr) {
+                    return false;
+                }
+                // the kernel updates the page under a sequence lock of its own
+                uint32_t sequence;
+                uint64_t count;
+                do {
+                    sequence = page->lock;
+                    std::atomic_signal_fence(std::memory_order_seq_cst);
+                    const uint32_t index = page->index;
+                    if (!page->cap_user_rdpmc || index == 0) {
+                        return false;
+                    }
+                    const auto shift = 64 - page->pmc_width;
+                    const auto counter = static_cast<int64_t>(rdpmc(index - 1) << shift) >> shift;
+                    count = page->offset + static_cast<uint64_t>(counter);
+                    std::atomic_signal_fence(std::memory_order_seq_cst);
+                } while (page->lock != sequence);
+                values[i] = count;
+            }
+            return true;
+#else
+            static_cast<void>(values);
+            return false;
+#endif
+        }
+
+        [[nodiscard]] Values read() const {
+            if (auto values = Values{}; read_user(values)) {
+                return values;
+            }
+            struct {
+                uint64_t nr;
+                Values values;
+            } group{};
+            if (!opened() || ::read(fds_[0], &group, sizeof(group)) != sizeof(group)) {
+                return {};
+            }
+            return group.values;
+        }
+
+        // How read() gets the counters, for the report.
+        [[nodiscard]] std::string method() const {
+            if (!opened()) {
+                return "clock only";
+            }
+            if (auto values = Values{}; read_user(values)) {
+                return "counters read with rdpmc";
+            }
+            return "counters read with read(2)";
+        }
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Totals {
+        size_t calls = 0;
+        Clock::duration time{};
+        Counters::Values counters{};
+
+        Totals& operator+=(const Totals&other) {
+            calls += other.calls;
+            time += other.time;
+            for (size_t i = 0; i < counters.size(); i++) {
+                counters[i] += other.counters[i];
+            }
+            return *this;
+        }
+    };
+
+    using RegionTotals = std::array<Totals, region_names.size()>;
+
+    // set by enable(), every thread opens its own counters on its first region after that
+    inline std::atomic<bool> enabled{false};
+
+    // what the threads that have already exited counted
+    struct Finished {
+        std::mutex mutex;
+        RegionTotals totals{};
+        std::string error;
+        std::string reader;
+        Clock::duration boundary{};
+    };
+
+    inline Finished& finished() {
+        static Finished finished;
+        return finished;
+    }
+
+    // Counts are exclusive: time spent in a nested region (the objective inside a step)
+    // goes to the nested region only.
+    class Profiler {
+        bool opened_ = false;
+        std::string error_;
+        Counters counters_;
+        RegionTotals totals_{};
+        std::vector<Region> stack_;
+        Counters::Values last_counters_{};
+        Clock::time_point last_time_{};
+        // how the counters are read and what a boundary() costs, measured when they are opened
+        std::string reader_;
+        Clock::duration boundary_cost_{};
+
+        void measure_boundary() {
+            constexpr size_t probes = 256;
+            const auto begin = Clock::now();
+            for (size_t i = 0; i < probes; i++) {
+                static_cast<void>(Clock::now());
+                static_cast<void>(counters_.read());
+            }
+            boundary_cost_ = (Clock::now() - begin) / probes;
+            reader_ = counters_.method();
+        }
+
+        // gives everything since the previous boundary to the innermost open region
+        void boundary() {
+            const auto now = Clock::now();
+            const auto values = counters_.read();
+            if (!stack_.empty()) {
+                auto&totals = totals_[static_cast<size_t>(stack_.back())];
+                totals.time += now - last_time_;
+                for (size_t i = 0; i < values.size(); i++) {
+                    totals.counters[i] += values[i] - last_counters_[i];
+                }
+            }
+            last_time_ = now;
+            last_counters_ = values;
+        }
+
+    public:
+        Profiler() = default;
+
+        Profiler(const Profiler&) = delete;
+
+        Profiler& operator=(const Profiler&) = delete;
+
+        // runs when the thread exits, so a worker's counts outlive it
+        ~Profiler() {
+            if (!opened_) {
+                return;
+            }
+            auto&[mutex, totals, error, reader, boundary] = finished();
+            std::lock_guard lock(mutex);
+            for (size_t i = 0; i < totals.size(); i++) {
+                totals[i] += totals_[i];
+            }
+            if (error.empty()) {
+                error = error_;
+            }
+            if (reader.empty()) {
+                reader = reader_;
+                boundary = boundary_cost_;
+            }
+        }
+
+        [[nodiscard]] bool active() {
+            if (!opened_ && enabled.load(std::memory_order_relaxed)) {
+                opened_ = true;
+                error_ = counters_.open();
+                measure_boundary();
+            }
+            return opened_;
+        }
+
+        void enter(const Region region) {
+            boundary();
+            stack_.push_back(region);
+            totals_[static_cast<size_t>(region)].calls += 1;
+        }
+
+        void leave() {
+            boundary();
+            stack_.pop_back();
+        }
+
+        // this thread's counts together with those of the exited threads
+        [[nodiscard]] std::string report() {
+            auto all = totals_;
+            auto error = error_;
+            auto reader = reader_;
+            auto boundary = boundary_cost_;
+            {
+                auto&shared = finished();
+                std::lock_guard lock(shared.mutex);
+                for (size_t i = 0; i < all.size(); i++) {
+                    all[i] += shared.totals[i];
+                }
+                if (error.empty()) {
+                    error = shared.error;
+                }
+                if (reader.empty()) {
+                    reader = shared.reader;
+                    boundary = shared.boundary;
+                }
+            }
+
+            std::ostringstream oss;
+            if (!error.empty()) {
+                oss << "hardware counters unavailable (" << error << "), wall time only\n";
+            }
+            oss << std::left << std::setw(12) << "region" << std::right
+                    << std::setw(12) << "calls" << std::setw(14) << "time, us"
+                    << std::setw(16) << "cycles" << std::setw(16) << "instructions" << std::setw(8) << "IPC"
+                    << std::setw(14) << "cache-misses" << std::setw(14) << "branch-misses" << '\n';
+            for (size_t i = 0; i < all.size(); i++) {
+                const auto&[calls, time, counters] = all[i];
+                const auto ipc = counters[0] == 0 ? 0.0 : static_cast<double>(counters[1]) / counters[0];
+                oss << std::left << std::setw(12) << region_names[i] << std::right
+                        << std::setw(12) << calls
+                        << std::setw(14) << std::chrono::duration_cast<std::chrono::microseconds>(time).count()
+                        << std::setw(16) << counters[0] << std::setw(16) << counters[1]
+                        << std::setw(8) << std::fixed << std::setprecision(2) << ipc
+                        << std::setw(14) << counters[2] << std::setw(14) << counters[3] << '\n';
+            }
+            if (!reader.empty()) {
+                // two boundaries per region call, half of each lands in the region
+                oss << "a region boundary costs about "
+                        << std::chrono::duration_cast<std::chrono::nanoseconds>(boundary).count()
+                        << " ns (" << reader << "), twice per call, included above\n";
+            }
+            return oss.str();
+        }
+    };
+
+    // Counters are per thread, so is the profiler.
+    inline Profiler& profiler() {
+        thread_local Profiler profiler;
+        return profiler;
+    }
+
+    inline void enable() {
+        enabled = true;
+    }
+
+    // Workers must have exited by now, their counts are merged when they do.
+    inline std::string report() {
+        return profiler().report();
+    }
+
+    class Scope {
+        bool active_;
+
+    public:
+        explicit Scope(const Region region) : active_(profiler().active()) {
+            if (active_) {
+                profiler().enter(region);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope() {
+            if (active_) {
+                profiler().leave();
+            }
+        }
+    };
+
+    inline Function objective(const Function&func) {
+        if (!profiler().active()) {
+            return func;
+        }
+        return [&func](const Point&point) {
+            Scope scope(Region::objective);
+            return func(point);
+        };
+    }
+}
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(region) profile::Scope PROFILE_CONCAT(profile_scope_, __LINE__)(profile::Region::region)
+
+#else
+
+namespace profile {
+    inline void enable() {
+    }
+
+    inline std::string report() {
+        return "built without profiling, configure with -DNELDERMEAD_PROFILE=ON\n";
+    }
+
+    inline const Function& objective(const Function&func) {
+        return func;
+    }
+}
+
+#define PROFILE_SCOPE(region)
+
+#endif
+
+#endif //PROFILE_H
@@ -0,0 +1,213 @@
+#ifndef SHARED_INCUMBENT_H
+#define SHARED_INCUMBENT_H
+
+#include <atomic>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "point.h"
+
+// Best point of all the processes attached to the same POSIX shared memory segment (see shm_open(3)).
+//
+// The segment is a seqlock: writers make the sequence odd, write, and make it even again,
+// readers retry until they see the same even sequence before and after copying.
+// Nobody ever blocks a reader, and a writer only waits for another writer.
+// A fresh segment is zero-filled: sequence == 0 means nothing has been published yet,
+// and sequence == 1 that the first publish is still being written.
+//
+// A process killed inside a write leaves the sequence odd for good, so every wait is bounded:
+// after `max_spins` a writer gives up publishing and a reader returns nothing. A writer that
+// gives up marks the segment as dead in this process, which stops publishing and reading from then on.
+class SharedIncumbent {
+    struct Header {
+        std::atomic<uint64_t> sequence;
+        // fingerprint of the run the segment belongs to, 0 in a fresh segment
+        std::atomic<uint64_t> run;
+        std::atomic<double> value;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<double>::is_always_lock_free,
+                  "shared memory needs address-free atomics");
+
+    static constexpr size_t max_spins = 1 << 20;
+
+    std::string name_;
+    size_t dimensions_;
+    size_t size_;
+    void* memory_ = nullptr;
+    std::atomic<bool> dead_ = false;
+
+    // a writer died inside a write, waiting for it again would cost `max_spins` on every improvement
+    void abandon() {
+        if (!dead_.exchange(true)) {
+            std::cerr << "warning: shared segment " << name_ << " is stuck in a write, no longer sharing\n";
+        }
+    }
+
+    [[nodiscard]] Header& header() const {
+        return *static_cast<Header*>(memory_);
+    }
+
+    [[nodiscard]] std::atomic<double>* coordinates() const {
+        return reinterpret_cast<std::atomic<double>*>(static_cast<char*>(memory_) + sizeof(Header));
+    }
+
+    // FNV-1a, the same in every process, never 0
+    static uint64_t fingerprint(const std::string&run) {
+        uint64_t ret = 14695981039346656037ull;
+        for (const auto c: run) {
+            ret = (ret ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        return ret == 0 ? 1 : ret;
+    }
+
+public:
+    // Attaches to the segment `name` (like "/neldermead"), creating it if needed.
+    // `run` describes the search (function, area, run id): attaching to a segment
+    // left by another run fails instead of seeding this one with its best point.
+    SharedIncumbent(std::string name, const size_t dimensions, const std::string&run)
+        : name_(std::move(name)),
+          dimensions_(dimensions),
+          size_(sizeof(Header) + dimensions * sizeof(std::atomic<double>)) {
+        const auto fd = shm_open(name_.c_str(), O_CREAT | O_RDWR, 0600);
+        if (fd < 0) {
+            throw std::runtime_error("shm_open failed for " + name_);
+        }
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::runtime_error("fstat failed for " + name_);
+        }
+        // resizing to the same size keeps the contents, so racing creators are fine
+        if (st.st_size != 0 && static_cast<size_t>(st.st_size) != size_) {
+            close(fd);
+            throw std::invalid_argument("shared segment " + name_ + " is from other dimension");
+        }
+        if (st.st_size == 0 && ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+            close(fd);
+            throw std::runtime_error("ftruncate failed for " + name_);
+        }
+
+        memory_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (memory_ == MAP_FAILED) {
+            throw std::runtime_error("mmap failed for " + name_);
+        }
+
+        // the first process to attach claims the segment
+        const auto expected = fingerprint(run);
+        if (auto owner = uint64_t{0};
+            !header().run.compare_exchange_strong(owner, expected) && owner != expected) {
+            munmap(memory_, size_);
+            throw std::invalid_argument("shared segment " + name_ + " belongs to another run, remove it first");
+        }
+    }
+
+    SharedIncumbent(const SharedIncumbent&) = delete;
+
+    SharedIncumbent& operator=(const SharedIncumbent&) = delete;
+
+    ~SharedIncumbent() {
+        munmap(memory_, size_);
+    }
+
+    // Removes the segment, attached processes keep their mapping.
+    static void unlink(const std::string&name) {
+        shm_unlink(name.c_str());
+    }
+
+    // Returns true if `point` became the best one of all processes.
+    bool publish(const Point&point, const double value) {
+        if (point.size() != dimensions_) {
+            throw std::invalid_argument("the point is from other dimestion");
+        }
+
+        if (dead_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        auto&[sequence, run, best] = header();
+        // cheap rejection, most of the calls are not improvements
+        if (auto seq = sequence.load(std::memory_order_relaxed);
+            seq > 1 && !(value < best.load(std::memory_order_relaxed))) {
+            return false;
+        }
+
+        auto seq = sequence.load(std::memory_order_relaxed);
+        for (size_t spins = 0;; spins++) {
+            if (spins == max_spins) {
+                abandon();
+                return false;
+            }
+            if (seq & 1) {
+                seq = sequence.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire)) {
+                break;
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const auto improved = seq == 0 || value < best.load(std::memory_order_relaxed);
+        if (improved) {
+            best.store(value, std::memory_order_relaxed);
+            for (size_t i = 0; i < dimensions_; i++) {
+                coordinates()[i].store(point[i], std::memory_order_relaxed);
+            }
+        }
+
+        sequence.store(seq + 2, std::memory_order_release);
+        return improved;
+    }
+
+    // The value only, without the retry loop. Any write but the first one replaces
+    // a published value with a better one, so a write in progress is fine here.
+    [[nodiscard]] std::optional<double> value() const {
+        if (dead_.load(std::memory_order_relaxed) || header().sequence.load(std::memory_order_acquire) <= 1) {
+            return {};
+        }
+        return header().value.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::optional<PointValue> get() const {
+        if (dead_.load(std::memory_order_relaxed)) {
+            return {};
+        }
+
+        auto&[sequence, run, best] = header();
+        auto ret = Point{};
+        ret.resize(dimensions_);
+
+        for (size_t spins = 0; spins < max_spins; spins++) {
+            const auto before = sequence.load(std::memory_order_acquire);
+            if (before == 0) {
+                return {};
+            }
+            if (before & 1) {
+                continue;
+            }
+
+            const auto value = best.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < dimensions_; i++) {
+                ret[i] = coordinates()[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) {
+                return PointValue{std::move(ret), value};
+            }
+        }
+        return {};
+    }
+};
+
+#endif //SHARED_INCUMBENT_H
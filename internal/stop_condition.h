@@ -0,0 +1,52 @@
+#ifndef STOP_CONDITION_H
+#define STOP_CONDITION_H
+
+#include <chrono>
+#include <optional>
+#include <stop_token>
+
+// Tells a running method to give up and return the best point it has so far:
+// either someone requested a stop through the token, or the deadline has passed.
+class StopCondition {
+    using Clock = std::chrono::steady_clock;
+
+    // reading the clock is far more expensive than checking the token,
+    // so the deadline is only looked at every `clock_stride`-th iteration
+    static constexpr size_t clock_stride = 8;
+
+    std::stop_token token_;
+    std::optional<Clock::time_point> deadline_;
+
+public:
+    static StopCondition never() {
+        return StopCondition{};
+    }
+
+    static StopCondition at(const Clock::time_point deadline) {
+        auto ret = StopCondition{};
+        ret.deadline_ = deadline;
+        return ret;
+    }
+
+    static StopCondition after(const Clock::duration timeout) {
+        return at(Clock::now() + timeout);
+    }
+
+    StopCondition& cancellable(std::stop_token token) {
+        token_ = std::move(token);
+        return *this;
+    }
+
+    // `iteration` is the caller's loop counter, it's only used to throttle clock reads.
+    [[nodiscard]] bool reached(const size_t iteration = 0) const {
+        if (token_.stop_requested()) {
+            return true;
+        }
+        if (!deadline_.has_value() || iteration % clock_stride != 0) {
+            return false;
+        }
+        return Clock::now() >= deadline_.value();
+    }
+};
+
+#endif //STOP_CONDITION_H
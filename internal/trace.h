@@ -4,6 +4,7 @@
 #include "point.h"
 
 #include <iomanip>
+#include <optional>
 #include <sstream>
 
 namespace format {
@@ -27,10 +28,12 @@ class Tracer {
     std::function<void(const std::string&)> log_function = format::log;
     std::string prefix_;
     mutable size_t n_ = 0;
+    // skips formatting the message altogether, the hot loops trace every iteration
+    bool muted_ = false;
 
 public:
     static Tracer muted() {
-        return Tracer(format::pass);
+        return Tracer(true);
     }
 
     static Tracer logging() {
@@ -40,13 +43,16 @@ public:
     explicit Tracer(auto logger) : log_function(logger) {
     }
 
-    explicit Tracer(const bool muted) : log_function{} {
+    explicit Tracer(const bool muted) : log_function{}, muted_(muted) {
         if (muted) {
             log_function = format::pass;
         }
     }
 
     void trace(const Point&point, const double value) const {
+        if (muted_) {
+            return;
+        }
         std::ostringstream oss;
         oss << prefix_ << point << " -> " << value;
         log_function(oss.str());
@@ -54,6 +60,9 @@ public:
 
     void trace_polygon(const std::vector<Point>&curr, const std::vector<Point>&prev,
                        const std::optional<double> mse = {}) const {
+        if (muted_) {
+            return;
+        }
         std::ostringstream oss;
         oss << "#" << ++n_ << "\t" << prev << "\t->\t" << curr;
         if (mse.has_value()) {
@@ -63,6 +72,9 @@ public:
     }
 
     void trace_numbered(const Point&point, const double value) const {
+        if (muted_) {
+            return;
+        }
         std::ostringstream oss;
         oss << prefix_ << ++n_ << '.' << '\t' << point << " -> " << value;
         log_function(oss.str());
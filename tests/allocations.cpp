@@ -0,0 +1,64 @@
+// Checks that the solvers' iterations don't allocate: counts operator new calls
+// between objective calls once the first ones are done.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "../internal/method_nelder_mead.h"
+#include "../internal/method_random_walk.h"
+#include "../internal/test_functions.h"
+
+static size_t allocations = 0;
+
+void* operator new(const size_t size) {
+    allocations++;
+    if (void* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// allocations made from the `warmup`-th objective call to the last one
+static size_t steady_allocations(const Method&method, const Area&area, const size_t warmup) {
+    size_t calls = 0, first = 0, last = 0;
+    const Function func = [&](const Point&point) {
+        if (++calls == warmup) {
+            first = allocations;
+        }
+        last = allocations;
+        return rastrigin_function(point);
+    };
+    method.minimal(func, area);
+    return calls < warmup ? 0 : last - first;
+}
+
+int main() {
+    int failed = 0;
+    const auto check = [&](const char* name, const size_t dimensions, const size_t count) {
+        std::printf("%s, D = %zu: %zu allocations\n", name, dimensions, count);
+        failed |= count != 0;
+    };
+
+    for (const size_t dimensions: {2, 10, 200}) {
+        const auto area = Area::cube(dimensions, -5, 5);
+
+        auto nelder = NelderMeadMethod(Tracer::muted(), 1e-12, area.simplex_around(area.random_point(), 0.1));
+        nelder.report_to(std::make_shared<BestSoFar>())
+                .stop_when(StopCondition::after(std::chrono::milliseconds(500)));
+        check("nelder mead", dimensions, steady_allocations(nelder, area, 5 * (dimensions + 1)));
+
+        auto walk = RandomWalk(Tracer::muted(), 1e-12, 1000, 20000);
+        walk.report_to(std::make_shared<BestSoFar>());
+        check("random walk", dimensions, steady_allocations(walk, area, 10));
+    }
+    return failed;
+}
@@ -0,0 +1,38 @@
+// Checks that every point ScreenAndPolish::minima() returns is a local minimum:
+// none of its neighbours a small step away along an axis is lower.
+#include <iostream>
+
+#include "../internal/method_screen_polish.h"
+#include "../internal/test_functions.h"
+
+static constexpr double step = 1e-4;
+
+int main() {
+    int failed = 0;
+    for (const size_t dimensions: {2, 3}) {
+        const auto area = Area::cube(dimensions, -5, 5);
+        for (size_t run = 0; run < 5; run++) {
+            auto method = ScreenAndPolish();
+            method.report_to(std::make_shared<BestSoFar>());
+
+            const auto minima = method.minima(rastrigin_function, area);
+            size_t bad = 0;
+            for (const auto&[point, value]: minima) {
+                for (size_t i = 0; i < dimensions; i++) {
+                    for (const auto delta: {step, -step}) {
+                        auto neighbour = point;
+                        neighbour[i] += delta;
+                        if (rastrigin_function(neighbour) < value) {
+                            std::cout << "not a minimum: " << point << ", function value = " << value << "\n";
+                            bad += 1;
+                        }
+                    }
+                }
+            }
+            std::cout << "D = " << dimensions << ", run " << run << ": "
+                    << minima.size() << " minima, " << bad << " bad\n";
+            failed |= bad != 0;
+        }
+    }
+    return failed;
+}